@@ -0,0 +1,20 @@
+-- SPDX-FileCopyrightText: 2025 Dyne.org foundation
+-- SPDX-License-Identifier: GPL-3.0-or-later
+
+-- Closures with upvalues created in tight loops.
+
+local function counter(start)
+  local n = start
+  return function(step)
+    n = n + step
+    return n
+  end
+end
+
+local sum = 0
+for i = 1, 1000000 do
+  local c = counter(i)
+  local twice = function(x) return c(c(x)) end
+  sum = sum + twice(1)
+end
+assert(sum > 0)
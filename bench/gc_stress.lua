@@ -0,0 +1,23 @@
+-- SPDX-FileCopyrightText: 2025 Dyne.org foundation
+-- SPDX-License-Identifier: GPL-3.0-or-later
+
+-- Build and drop trees while stepping the garbage collector.
+
+local function tree(depth)
+  if depth == 0 then return { leaf = true } end
+  return { left = tree(depth - 1), right = tree(depth - 1) }
+end
+
+local function count(t)
+  if t.leaf then return 1 end
+  return count(t.left) + count(t.right)
+end
+
+local keep = {}
+for i = 1, 200 do
+  local t = tree(12)
+  assert(count(t) == 4096)
+  keep[i % 8 + 1] = t
+  collectgarbage("step", 64)
+end
+collectgarbage("collect")
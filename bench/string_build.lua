@@ -0,0 +1,15 @@
+-- SPDX-FileCopyrightText: 2025 Dyne.org foundation
+-- SPDX-License-Identifier: GPL-3.0-or-later
+
+-- String building by concatenation, formatting and buffers.
+
+local total = 0
+for i = 1, 20000 do
+  local s = ""
+  for j = 1, 16 do s = s .. string.format("%02x", (i + j) % 256) end
+  local parts = {}
+  for j = 1, 32 do parts[j] = s:sub(j, j + 7) end
+  local joined = table.concat(parts, ":")
+  total = total + #joined + #s:upper() + #s:rep(4)
+end
+assert(total > 0)
@@ -0,0 +1,17 @@
+-- SPDX-FileCopyrightText: 2025 Dyne.org foundation
+-- SPDX-License-Identifier: GPL-3.0-or-later
+
+-- Many short lived small tables, as produced by Zenroom schemas.
+
+local live = {}
+for i = 1, 2000000 do
+  local t = { i, i + 1, x = i, y = -i }
+  live[i % 1024 + 1] = t
+  if i % 7 == 0 then
+    local arr = {}
+    for j = 1, 16 do arr[j] = j end
+    table.remove(arr, 1)
+    table.insert(arr, 1, i)
+  end
+end
+assert(#live == 1024)
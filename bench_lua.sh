@@ -0,0 +1,59 @@
+#!/bin/sh
+# SPDX-FileCopyrightText: 2025 Dyne.org foundation
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+# Run the Lua benchmark scripts with the system allocator and with
+# sfpool on a grid of pool sizes, then print one comparison table.
+#
+# Environment:
+#   POOLS    space separated list of <blocks>:<blocksize>, set by
+#            make bench-lua from LUA_BENCH_POOLS
+#   REPEAT   runs of each cell, the median is reported (default 1)
+#   SCRIPTS  Lua scripts to run (default bench/*.lua)
+
+[ -n "$POOLS" ] || { echo "POOLS not set: run make bench-lua" >&2; exit 1; }
+REPEAT=${REPEAT:-1}
+SCRIPTS=${SCRIPTS:-$(ls bench/*.lua)}
+
+for bin in ./test_lua_system ./test_lua_sfpool; do
+  [ -x $bin ] || { echo "Missing $bin: run make bench-lua" >&2; exit 1; }
+done
+
+# $1 binary, $2 script, $3 blocks, $4 blocksize, $5 allocator, $6 pool label
+bench() {
+  i=0
+  while [ $i -lt "$REPEAT" ]; do
+    "$1" "$2" "$3" "$4" 2>&1 >/dev/null
+    i=$((i + 1))
+  done | awk -v name="$(basename "$2" .lua)" -v alloc="$5" -v pool="$6" '
+    function median(v, n,   i, j, t) {
+      for (i = 2; i <= n; i++)
+        for (j = i; j > 1 && v[j-1] > v[j]; j--) { t = v[j]; v[j] = v[j-1]; v[j-1] = t }
+      return n % 2 ? v[(n+1)/2] : (v[n/2] + v[n/2+1]) / 2
+    }
+    $1 == "sfpool-bench" {
+      n++; ms[n] = $2; rss[n] = $3; hits[n] = $4; miss[n] = $5; fbb[n] = $6
+    }
+    END {
+      if (!n) { printf "%-14s %-8s %-11s %10s\n", name, alloc, pool, "failed"; exit }
+      hit = "-"; fb = "-"
+      if (alloc != "system") {
+        h = median(hits, n); m = median(miss, n)
+        hit = sprintf("%.1f", h + m ? h * 100 / (h + m) : 0)
+        fb = sprintf("%.1f", median(fbb, n) / 1024)
+      }
+      printf "%-14s %-8s %-11s %10.2f %10d %7s %12s\n",
+             name, alloc, pool, median(ms, n), median(rss, n), hit, fb
+    }'
+}
+
+rev=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+echo "🌊 sfpool Lua benchmark at commit $rev (median of $REPEAT runs)"
+printf "%-14s %-8s %-11s %10s %10s %7s %12s\n" \
+       script alloc pool "wall ms" "rss KB" "hit %" "fallback KB"
+for script in $SCRIPTS; do
+  bench ./test_lua_system "$script" 0 0 system -
+  for p in $POOLS; do
+    bench ./test_lua_sfpool "$script" "${p%%:*}" "${p##*:}" sfpool "${p%%:*}x${p##*:}"
+  done
+done
@@ -30,9 +30,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <time.h>
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #elif defined(_WIN32)
@@ -42,11 +44,20 @@
 #include <unistd.h> // for geteuid to switch protected memory map
 #include <sys/resource.h>
 #include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h> // for memfd_create backing pool snapshots
+#define SFPOOL_SNAPSHOT
+#endif
 #endif
 
 // Configuration
+#ifndef NO_SECURE_ZERO
 #define SECURE_ZERO // Enable secure zeroing
+#endif
 #define PROFILING // Profile most used sizes allocated
+#ifndef NO_SAFE_LINKING
+#define SAFE_LINKING // Encode and check free-list links
+#endif
 
 #if defined(__x86_64__) || defined(_M_X64) || defined(__ppc64__) || defined(__LP64__)
 #define ptr_t uint64_t
@@ -58,6 +69,10 @@
 #define struct_align 8
 #endif
 
+struct sfpool_t;
+/** Callback invoked on pool pressure to reclaim blocks before fallback. */
+typedef void (*sfpool_pressure_fn)(struct sfpool_t *pool, void *ud);
+
 // Memory pool structure
 typedef struct __attribute__((aligned(struct_align))) sfpool_t {
   uint8_t *buffer; // raw
@@ -67,6 +82,18 @@ typedef struct __attribute__((aligned(struct_align))) sfpool_t {
   uint32_t total_blocks;
   uint32_t total_bytes;
   uint32_t block_size;
+  uint32_t live_fallbacks; // system malloc allocations not yet freed
+  uint8_t *arena; // bump area for oversized allocations, if any
+  uint8_t *arena_top;
+  uint8_t *arena_end;
+#ifdef SAFE_LINKING
+  ptr_t link_secret; // per-pool key for free-list links
+#endif
+  sfpool_pressure_fn pressure_cb;
+  void *pressure_ud;
+  uint32_t low_watermark;
+  uint32_t in_pressure; // guards against reentrant callbacks
+  uint32_t pressure_armed; // re-armed once above the watermark
 #ifdef PROFILING
   uint32_t *hits;
   uint32_t hits_total;
@@ -74,6 +101,9 @@ typedef struct __attribute__((aligned(struct_align))) sfpool_t {
   uint32_t miss_total;
   size_t   miss_bytes;
   size_t   alloc_total;
+  uint32_t pressure_calls;
+  uint32_t pressure_saved; // calls refilling an exhausted pool
+  size_t   pressure_blocks; // blocks reclaimed by the callback
 #endif
 } sfpool_t;
 
@@ -87,6 +117,42 @@ static inline bool _is_in_pool(sfpool_t *pool, const void *ptr) {
          && p < (ptr_t)(pool->data + pool->total_bytes));
 }
 
+static inline bool _is_in_arena(sfpool_t *pool, const void *ptr) {
+  ptr_t p = (ptr_t)ptr;
+  return(p >= (ptr_t)pool->arena && p < (ptr_t)pool->arena_end);
+}
+
+// Free-list links are stored in the first word of each free block
+// (or past the object for idle objects in caches).
+// With SAFE_LINKING they are XORed with a per-pool secret and with the
+// address of the slot holding them, then checked on load to decode into
+// a block-aligned address inside the pool, so that a use-after-free
+// write cannot redirect sfpool_malloc outside of it.
+static inline void _sfpool_link(sfpool_t *pool, uint8_t *block, uint8_t *next) {
+#ifdef SAFE_LINKING
+  *(ptr_t *)block = (ptr_t)next ^ (ptr_t)block ^ pool->link_secret;
+#else
+  (void)pool;
+  *(uint8_t **)block = next;
+#endif
+}
+
+static inline uint8_t *_sfpool_next(sfpool_t *pool, uint8_t *block) {
+#ifdef SAFE_LINKING
+  ptr_t next = *(ptr_t *)block ^ (ptr_t)block ^ pool->link_secret;
+  ptr_t offset = next - (ptr_t)pool->data;
+  if (next != 0 && (offset >= pool->total_bytes
+                    || (offset & (pool->block_size - 1)) != 0)) {
+    fprintf(stderr,"sfpool free list corrupted at %p\n",(void*)block);
+    abort();
+  }
+  return (uint8_t *)next;
+#else
+  (void)pool;
+  return *(uint8_t **)block;
+#endif
+}
+
 /**
  * @defgroup sfutil Internal Utilities
  * @{
@@ -119,6 +185,16 @@ static inline void *sfutil_memalign(const void* ptr) {
     return (void*)aligned;
 }
 
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32) && !defined(__APPLE__)
+// Returns MAP_LOCKED when a mapping of size bytes fits the memlock limit
+static inline int _sfutil_lockflag(size_t size) {
+	struct rlimit rl;
+	if (getrlimit(RLIMIT_MEMLOCK, &rl) == 0)
+		if(size<=rl.rlim_cur) return MAP_LOCKED;
+	return 0;
+}
+#endif
+
 /**
  * @brief Allocates memory securely.
  *
@@ -143,9 +219,7 @@ static inline void *sfutil_secalloc(size_t size) {
 	mlock(res, alloc_size);
 #else // assume POSIX
 	int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
-	struct rlimit rl;
-	if (getrlimit(RLIMIT_MEMLOCK, &rl) == 0)
-		if(alloc_size<=rl.rlim_cur) flags |= MAP_LOCKED;
+	flags |= _sfutil_lockflag(alloc_size);
 	res = mmap(NULL, alloc_size, PROT_READ | PROT_WRITE, flags, -1, 0);
 	if (res == MAP_FAILED) return NULL;
 #endif
@@ -179,46 +253,43 @@ static inline void sfutil_secfree(void *ptr, size_t size) {
  * @{
  */
 
-/**
- * @brief Initializes a memory pool.
- *
- * This function initializes a memory pool with a specified number of blocks and block size.
- * The block size must be a power of two.
- *
- * @param pool Pointer to the memory pool structure to initialize.
- * @param nmemb Number of blocks in the pool.
- * @param blocksize Size of each block in bytes.
- * @return Total size of the memory pool in bytes, or 0 on failure.
- */
-static inline size_t sfpool_init(sfpool_t *pool, size_t nmemb, size_t blocksize) {
-  if (pool == NULL) return 0;
-  memset(pool, 0, sizeof(sfpool_t));
-  if (nmemb == 0) return 0;
-  if (blocksize < sizeof(void*)) return 0;
-  if((blocksize & (blocksize - 1)) != 0) return 0;
-  if (nmemb > (SIZE_MAX / blocksize)) return 0;
-  // SFPool blocksize must be a power of two
+// Checks the pool geometry: block size must be a power of two
+// holding a pointer and the pool size must fit in total_bytes
+static inline bool _sfpool_valid(size_t nmemb, size_t blocksize) {
+  if (nmemb == 0) return false;
+  if (blocksize < sizeof(void*)) return false;
+  if ((blocksize & (blocksize - 1)) != 0) return false;
+  return nmemb <= UINT32_MAX / blocksize;
+}
+
+// Lays out the embedded free list over an allocated pool buffer
+static inline size_t _sfpool_format(sfpool_t *pool, size_t nmemb, size_t blocksize) {
   size_t totalsize = nmemb * blocksize;
-  pool->buffer = sfutil_secalloc(totalsize);
-  if (pool->buffer == NULL) return 0;
-  // Failed to allocate pool memory
-  pool->data   = sfutil_memalign(pool->buffer);
+  pool->data   = (uint8_t*)sfutil_memalign(pool->buffer);
   if (pool->data == NULL) return 0;
   // Failed to allocate pool memory
   pool->total_bytes  = totalsize;
   pool->total_blocks = nmemb;
   pool->block_size   = blocksize;
+#ifdef SAFE_LINKING
+  // Cheap secret mixing address space randomization and time
+  uint64_t seed = (uint64_t)(ptr_t)pool->buffer ^ (uint64_t)(ptr_t)&seed
+    ^ ((uint64_t)time(NULL) << 20) ^ (uint64_t)clock();
+  seed += 0x9E3779B97F4A7C15ULL; // splitmix64 finalizer
+  seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+  pool->link_secret = (ptr_t)(seed ^ (seed >> 31));
+#endif
   // Initialize the embedded free list
   pool->free_list = pool->data;
   register uint32_t i, bi;
   for (i = 0; i < pool->total_blocks - 1; ++i) {
     bi = i*blocksize;
-    *(uint8_t **)(pool->data + bi) =
-      pool->data + bi + blocksize;
+    _sfpool_link(pool, pool->data + bi, pool->data + bi + blocksize);
   }
   pool->free_count = pool->total_blocks;
-  *(uint8_t **)
-    (pool->data + (pool->total_blocks - 1) * blocksize) = NULL;
+  _sfpool_link(pool,
+    pool->data + (pool->total_blocks - 1) * blocksize, NULL);
 #ifdef PROFILING
   pool->miss_total = pool->miss_bytes = 0;
   pool->hits_total = pool->hits_bytes = 0;
@@ -227,6 +298,28 @@ static inline size_t sfpool_init(sfpool_t *pool, size_t nmemb, size_t blocksize)
   return totalsize;
 }
 
+/**
+ * @brief Initializes a memory pool.
+ *
+ * This function initializes a memory pool with a specified number of blocks and block size.
+ * The block size must be a power of two.
+ *
+ * @param pool Pointer to the memory pool structure to initialize.
+ * @param nmemb Number of blocks in the pool.
+ * @param blocksize Size of each block in bytes.
+ * @return Total size of the memory pool in bytes, or 0 on failure.
+ */
+static inline size_t sfpool_init(sfpool_t *pool, size_t nmemb, size_t blocksize) {
+  if (pool == NULL) return 0;
+  memset(pool, 0, sizeof(sfpool_t));
+  if (!_sfpool_valid(nmemb, blocksize)) return 0;
+  size_t totalsize = nmemb * blocksize;
+  pool->buffer = (uint8_t*)sfutil_secalloc(totalsize);
+  if (pool->buffer == NULL) return 0;
+  // Failed to allocate pool memory
+  return _sfpool_format(pool, nmemb, blocksize);
+}
+
 
 /**
  * @brief Tears down a memory pool.
@@ -245,11 +338,106 @@ static inline void sfpool_teardown(sfpool_t *restrict pool) {
 #endif
 }
 
+/**
+ * @brief Sets a callback to reclaim pool memory under pressure.
+ *
+ * The callback is invoked by `sfpool_malloc` before serving a pool sized
+ * allocation whenever the number of free blocks is at or below the
+ * low watermark, so the host can return blocks to the pool (for instance
+ * draining object caches or running an incremental garbage collection
+ * step) before the allocation falls back to system malloc. With a
+ * watermark of zero it is invoked only when the pool is exhausted.
+ * The callback may allocate and free, but it is never reentered.
+ * If a call leaves the free blocks still at or below the watermark,
+ * the callback is not invoked again ahead of exhaustion until frees
+ * bring them above it; once the pool is exhausted it is always invoked
+ * before falling back.
+ *
+ * @param pool Pointer to the memory pool structure.
+ * @param cb Callback to invoke, or NULL to disable it.
+ * @param ud User data passed to the callback.
+ * @param low_watermark Number of free blocks at or below which to invoke it.
+ */
+static inline void sfpool_set_pressure_cb(sfpool_t *pool, sfpool_pressure_fn cb,
+                                          void *ud, uint32_t low_watermark) {
+  pool->pressure_cb = cb;
+  pool->pressure_ud = ud;
+  pool->low_watermark = low_watermark;
+  pool->pressure_armed = (cb != NULL);
+}
+
+// Re-arms the pressure callback once free blocks are above the watermark
+static inline void _sfpool_rearm(sfpool_t *pool) {
+  if (!pool->pressure_armed && pool->free_count > pool->low_watermark)
+    pool->pressure_armed = (pool->pressure_cb != NULL);
+}
+
+static inline void _sfpool_pressure(sfpool_t *pool) {
+  if (pool->in_pressure) return;
+  uint32_t before = pool->free_count;
+  bool exhausted = (pool->free_list == NULL);
+  pool->in_pressure = 1;
+  pool->pressure_cb(pool, pool->pressure_ud);
+  pool->in_pressure = 0;
+  pool->pressure_armed = (pool->free_count > pool->low_watermark);
+#ifdef PROFILING
+  pool->pressure_calls++;
+  if (pool->free_count > before) pool->pressure_blocks += pool->free_count - before;
+  if (exhausted && pool->free_list != NULL) pool->pressure_saved++;
+#else
+  (void)before;
+  (void)exhausted;
+#endif
+}
+
+// Oversized allocations are carved from the arena when the pool has
+// one, each preceded by a header holding its size; space is given back
+// only when the last allocation is freed and all of it on teardown.
+static inline size_t _sfpool_arena_span(size_t size) {
+  return ((size + struct_align - 1) & ~(size_t)(struct_align - 1)) + struct_align;
+}
+
+static inline void *_sfpool_arena_alloc(sfpool_t *pool, size_t size) {
+  if (size > SIZE_MAX - 2 * struct_align) return NULL;
+  size_t span = _sfpool_arena_span(size);
+  if (span > (size_t)(pool->arena_end - pool->arena_top)) return NULL;
+  uint8_t *header = pool->arena_top;
+  *(size_t *)header = size;
+  pool->arena_top += span;
+  return header + struct_align;
+}
+
+static inline size_t _sfpool_arena_size(const void *ptr) {
+  return *(const size_t *)((const uint8_t *)ptr - struct_align);
+}
+
+static inline void _sfpool_arena_free(sfpool_t *pool, void *ptr) {
+  size_t size = _sfpool_arena_size(ptr);
+#ifdef SECURE_ZERO
+  sfutil_zero(ptr, size);
+#endif
+  uint8_t *header = (uint8_t *)ptr - struct_align;
+  if (header + _sfpool_arena_span(size) == pool->arena_top)
+    pool->arena_top = header;
+}
+
+// Serves allocations that do not fit a pool block
+static inline void *_sfpool_fallback(sfpool_t *pool, size_t size) {
+  void *ptr = NULL;
+  if (pool->arena != NULL) ptr = _sfpool_arena_alloc(pool, size);
+  if (ptr == NULL) {
+    ptr = malloc(size);
+    if (ptr != NULL) pool->live_fallbacks++;
+  }
+  return ptr;
+}
+
 /**
  * @brief Allocates memory from the pool.
  *
  * This function allocates memory from the pool if the requested size is within the block size.
- * Otherwise, it falls back to system malloc.
+ * Otherwise, it falls back to system malloc. When the pool is low on free blocks the
+ * pressure callback set by `sfpool_set_pressure_cb` is given a chance to reclaim them first.
  *
  * @param opaque Pointer to the memory pool structure.
  * @param size Size of the memory block to allocate.
@@ -258,6 +446,11 @@ static inline void sfpool_teardown(sfpool_t *restrict pool) {
 static inline void *sfpool_malloc(void *restrict opaque, const size_t size) {
   sfpool_t *pool = (sfpool_t*)opaque;
   void *ptr;
+  if (size <= pool->block_size
+      && pool->free_count <= pool->low_watermark
+      && (pool->pressure_armed
+          || (pool->free_list == NULL && pool->pressure_cb != NULL)))
+    _sfpool_pressure(pool);
   if (size <= pool->block_size
       && pool->free_list != NULL) {
 #ifdef PROFILING
@@ -267,12 +460,12 @@ static inline void *sfpool_malloc(void *restrict opaque, const size_t size) {
 #endif
     // Remove the first block from the free list
     uint8_t *block = pool->free_list;
-    pool->free_list = *(uint8_t **)block;
+    pool->free_list = _sfpool_next(pool, block);
     pool->free_count-- ;
     return block;
   }
   // Fallback to system malloc for large allocations
-  ptr = malloc(size);
+  ptr = _sfpool_fallback(pool, size);
   if(ptr == NULL) perror("system malloc error");
 #ifdef PROFILING
   pool->miss_total++;
@@ -301,12 +494,16 @@ static inline void sfpool_free(void *restrict opaque, void *ptr) {
     sfutil_zero(ptr, pool->block_size);
 #endif
     // Add the block back to the free list
-    *(uint8_t **)ptr = pool->free_list;
+    _sfpool_link(pool, (uint8_t *)ptr, pool->free_list);
     pool->free_list = (uint8_t *)ptr;
     pool->free_count++ ;
+    _sfpool_rearm(pool);
     return;
+  } else if (_is_in_arena(pool, ptr)) {
+    _sfpool_arena_free(pool, ptr);
   } else {
     free(ptr);
+    pool->live_fallbacks--;
   }
 }
 
@@ -341,7 +538,7 @@ static inline void *sfpool_realloc(void *restrict opaque, void *ptr, const size_
 #endif
       return ptr; // No need to reallocate
     } else {
-      void *new_ptr = malloc(size);
+      void *new_ptr = _sfpool_fallback(pool, size);
       if (new_ptr == NULL) return NULL;
       memcpy(new_ptr, ptr, pool->block_size); // Copy only BLOCK_SIZE bytes
 #ifdef SECURE_ZERO
@@ -349,9 +546,10 @@ static inline void *sfpool_realloc(void *restrict opaque, void *ptr, const size_
       sfutil_zero(ptr, pool->block_size);
 #endif
       // Add the block back to the free list
-      *(uint8_t **)ptr = pool->free_list;
+      _sfpool_link(pool, (uint8_t *)ptr, pool->free_list);
       pool->free_list = (uint8_t *)ptr;
       pool->free_count++ ;
+      _sfpool_rearm(pool);
 #ifdef PROFILING
   pool->miss_total++;
   pool->miss_bytes+=size;
@@ -361,12 +559,30 @@ static inline void *sfpool_realloc(void *restrict opaque, void *ptr, const size_
     }
   } else {
     // Handle large allocations
-    return realloc(ptr, size);
 #ifdef PROFILING
     pool->miss_total++;
     pool->miss_bytes+=size;
     pool->alloc_total+=size;
 #endif
+    if (_is_in_arena(pool, ptr)) {
+      size_t old_size = _sfpool_arena_size(ptr);
+      if (size <= old_size) return ptr;
+      uint8_t *header = (uint8_t *)ptr - struct_align;
+      if (header + _sfpool_arena_span(old_size) == pool->arena_top
+          && size <= SIZE_MAX - 2 * struct_align
+          && _sfpool_arena_span(size) <= (size_t)(pool->arena_end - header)) {
+        // Grow the last arena allocation in place
+        *(size_t *)header = size;
+        pool->arena_top = header + _sfpool_arena_span(size);
+        return ptr;
+      }
+      void *new_ptr = _sfpool_fallback(pool, size);
+      if (new_ptr == NULL) return NULL;
+      memcpy(new_ptr, ptr, old_size);
+      _sfpool_arena_free(pool, ptr);
+      return new_ptr;
+    }
+    return realloc(ptr, size);
   }
 }
 
@@ -398,14 +614,396 @@ static inline int sfpool_contains(void *restrict opaque, const void *ptr) {
 static inline void sfpool_status(sfpool_t *restrict p) {
   fprintf(stderr,"\n🌊 sfpool: %u blocks %u B each\n",
           p->total_blocks, p->block_size);
+  if (p->arena)
+    fprintf(stderr,"🌊 Arena:  %lu K used of %lu K\n",
+            (unsigned long)(p->arena_top - p->arena)/1024,
+            (unsigned long)(p->arena_end - p->arena)/1024);
+  if (p->live_fallbacks)
+    fprintf(stderr,"🌊 Live:   %u system allocations\n", p->live_fallbacks);
 #ifdef PROFILING
   fprintf(stderr,"🌊 Total:  %lu K\n",
           p->alloc_total/1024);
   fprintf(stderr,"🌊 Misses: %lu K (%u calls)\n",p->miss_bytes/1024,p->miss_total);
   fprintf(stderr,"🌊 Hits:   %lu K (%u calls)\n",p->hits_bytes/1024,p->hits_total);
+  if (p->pressure_cb)
+    fprintf(stderr,"🌊 Pressure: %u calls (%u fallbacks prevented, %lu blocks reclaimed)\n",
+            p->pressure_calls,p->pressure_saved,p->pressure_blocks);
 #endif
 }
 
 /** @} */ // End of sfpool group
 
+
+/**
+ * @defgroup sfcache Object Cache API
+ * @{
+ */
+
+#ifndef SFPOOL_CACHE_SECRETS
+#define SFPOOL_CACHE_SECRETS 4 // Max secret ranges declared per cache
+#endif
+
+/** Constructor or destructor callback for cached objects. */
+typedef void (*sfpool_cache_fn)(void *obj);
+
+// Object cache structure
+typedef struct sfpool_cache_t {
+  sfpool_t *pool;
+  sfpool_cache_fn ctor;
+  sfpool_cache_fn dtor;
+  uint8_t *free_list; // idle pool objects kept in constructed state
+  uint32_t free_count;
+  uint32_t obj_size;
+  uint32_t link_offset; // free-list link stored past the object
+  uint32_t secret_count;
+  uint32_t secret_off[SFPOOL_CACHE_SECRETS];
+  uint32_t secret_len[SFPOOL_CACHE_SECRETS];
+#ifdef PROFILING
+  uint32_t hits_total;
+  uint32_t miss_total;
+  uint32_t free_total;
+#endif
+} sfpool_cache_t;
+
+/**
+ * @brief Creates a cache of constructed objects on top of a pool.
+ *
+ * Objects are carved from pool blocks and constructed once: after
+ * `sfpool_cache_free` they are kept in constructed state and handed
+ * out again by `sfpool_cache_alloc` without calling the constructor.
+ * Idle objects are linked like the pool free list by a pointer stored
+ * past the object, so the object size rounded up to `ptr_align` plus
+ * one pointer must fit in a pool block. Objects allocated from system
+ * malloc while the pool is exhausted are destructed and freed right
+ * away instead of being kept.
+ * Secret fields declared with `sfpool_cache_secret` are not part of
+ * the constructed state: they are always zero when handed out.
+ *
+ * @param pool Pointer to the memory pool backing the cache.
+ * @param size Size of each object in bytes.
+ * @param ctor Constructor called once per new object, or NULL to zero it.
+ * @param dtor Destructor called when an object leaves the cache, or NULL.
+ * @return Pointer to the new cache, or NULL on failure or if objects
+ *         do not fit in a pool block.
+ */
+static inline sfpool_cache_t *sfpool_cache_create(sfpool_t *pool, size_t size,
+                                                  sfpool_cache_fn ctor,
+                                                  sfpool_cache_fn dtor) {
+  if (pool == NULL || size == 0) return NULL;
+  if (size > UINT32_MAX - 2 * ptr_align) return NULL;
+  uint32_t link_offset = (size + ptr_align - 1) & ~(ptr_align - 1);
+  if (link_offset + sizeof(void*) > pool->block_size) return NULL;
+  sfpool_cache_t *cache = (sfpool_cache_t*)sfpool_malloc(pool, sizeof(sfpool_cache_t));
+  if (cache == NULL) return NULL;
+  memset(cache, 0, sizeof(sfpool_cache_t));
+  cache->pool = pool;
+  cache->ctor = ctor;
+  cache->dtor = dtor;
+  cache->obj_size = size;
+  cache->link_offset = link_offset;
+  return cache;
+}
+
+/**
+ * @brief Declares a secret-carrying field of the cached objects.
+ *
+ * The declared byte range is always zero when an object is handed out
+ * by `sfpool_cache_alloc`: it is zeroed after the constructor runs and
+ * securely zeroed each time the object is returned to the cache, while
+ * the rest of the object keeps its constructed state.
+ *
+ * @param cache Pointer to the object cache.
+ * @param offset Offset of the field inside the object.
+ * @param length Length of the field in bytes.
+ * @return 1 on success, 0 if the range is invalid or too many are declared.
+ */
+static inline int sfpool_cache_secret(sfpool_cache_t *cache,
+                                      size_t offset, size_t length) {
+  if (cache == NULL || length == 0) return 0;
+  if (offset > cache->obj_size || length > cache->obj_size - offset) return 0;
+  if (cache->secret_count >= SFPOOL_CACHE_SECRETS) return 0;
+  cache->secret_off[cache->secret_count] = offset;
+  cache->secret_len[cache->secret_count] = length;
+  cache->secret_count++;
+  return 1;
+}
+
+/**
+ * @brief Allocates a constructed object from the cache.
+ *
+ * Idle objects are reused first; otherwise a new object is taken from
+ * the pool and passed to the constructor. Declared secret fields are
+ * zero in both cases.
+ *
+ * @param cache Pointer to the object cache.
+ * @return Pointer to the object, or NULL on failure.
+ */
+static inline void *sfpool_cache_alloc(sfpool_cache_t *restrict cache) {
+  uint32_t i;
+  uint8_t *obj = cache->free_list;
+  if (obj != NULL) {
+    cache->free_list = _sfpool_next(cache->pool, obj + cache->link_offset);
+    cache->free_count--;
+#ifdef PROFILING
+    cache->hits_total++;
+#endif
+    return obj;
+  }
+  obj = (uint8_t*)sfpool_malloc(cache->pool, cache->link_offset + sizeof(void*));
+  if (obj == NULL) return NULL;
+  if (cache->ctor) cache->ctor(obj);
+  else memset(obj, 0, cache->obj_size);
+  for (i = 0; i < cache->secret_count; i++)
+    memset(obj + cache->secret_off[i], 0, cache->secret_len[i]);
+#ifdef PROFILING
+  cache->miss_total++;
+#endif
+  return obj;
+}
+
+/**
+ * @brief Returns an object to the cache.
+ *
+ * Declared secret fields are securely zeroed and the object is kept
+ * in constructed state for the next `sfpool_cache_alloc`, unless it
+ * lives outside of the pool blocks: then it is destructed and freed.
+ *
+ * @param cache Pointer to the object cache.
+ * @param obj Pointer to an object allocated from this cache.
+ */
+static inline void sfpool_cache_free(sfpool_cache_t *restrict cache, void *obj) {
+  if (obj == NULL) return;
+  uint32_t i;
+  for (i = 0; i < cache->secret_count; i++)
+    sfutil_zero((uint8_t*)obj + cache->secret_off[i], cache->secret_len[i]);
+#ifdef PROFILING
+  cache->free_total++;
+#endif
+  if (!_is_in_pool(cache->pool, obj)) {
+    if (cache->dtor) cache->dtor(obj);
+    sfpool_free(cache->pool, obj);
+    return;
+  }
+  _sfpool_link(cache->pool, (uint8_t*)obj + cache->link_offset, cache->free_list);
+  cache->free_list = (uint8_t*)obj;
+  cache->free_count++;
+}
+
+/**
+ * @brief Releases all idle objects of a cache back to its pool.
+ *
+ * Each idle object is destructed and freed, objects still in use are
+ * not affected.
+ *
+ * @param cache Pointer to the object cache.
+ * @return Number of objects released.
+ */
+static inline uint32_t sfpool_cache_reap(sfpool_cache_t *restrict cache) {
+  uint32_t released = 0;
+  uint8_t *obj = cache->free_list;
+  while (obj != NULL) {
+    uint8_t *next = _sfpool_next(cache->pool, obj + cache->link_offset);
+    if (cache->dtor) cache->dtor(obj);
+    sfpool_free(cache->pool, obj);
+    obj = next;
+    released++;
+  }
+  cache->free_list = NULL;
+  cache->free_count = 0;
+  return released;
+}
+
+/**
+ * @brief Destroys an object cache.
+ *
+ * All idle objects are released to the pool; objects still in use
+ * must be returned with `sfpool_cache_free` before calling this.
+ *
+ * @param cache Pointer to the object cache.
+ */
+static inline void sfpool_cache_destroy(sfpool_cache_t *cache) {
+  if (cache == NULL) return;
+  sfpool_cache_reap(cache);
+  sfpool_free(cache->pool, cache);
+}
+
+/**
+ * @brief Prints the status of an object cache.
+ *
+ * This function prints the object size, idle objects and profiling
+ * information (if enabled) including the ratio of allocations served
+ * without construction.
+ *
+ * @param c Pointer to the object cache.
+ */
+static inline void sfpool_cache_status(sfpool_cache_t *restrict c) {
+  fprintf(stderr,"\n🐟 sfcache: %u B objects, %u idle\n",
+          c->obj_size, c->free_count);
+#ifdef PROFILING
+  uint32_t calls = c->hits_total + c->miss_total;
+  fprintf(stderr,"🐟 Hits:   %u calls (%u%%)\n", c->hits_total,
+          calls ? (uint32_t)((uint64_t)c->hits_total * 100 / calls) : 0);
+  fprintf(stderr,"🐟 Misses: %u calls\n", c->miss_total);
+  fprintf(stderr,"🐟 Frees:  %u calls\n", c->free_total);
+#endif
+}
+
+/** @} */ // End of sfcache group
+
+
+#ifdef SFPOOL_SNAPSHOT
+/**
+ * @defgroup sfsnap Copy-on-Write Snapshot API
+ * @{
+ */
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MLOCK_ONFAULT
+#define MLOCK_ONFAULT 0x01U
+#endif
+
+// Pool snapshot structure
+typedef struct sfpool_snapshot_t {
+  int fd; // memfd holding the template contents
+  uint8_t *base; // fixed address where pool and clones are mapped
+  size_t map_size;
+  bool frozen;
+  sfpool_t state; // pool descriptor at freeze time
+} sfpool_snapshot_t;
+
+/**
+ * @brief Initializes a memory pool that can be frozen as a template.
+ *
+ * Like `sfpool_init`, but the pool memory is a shared mapping of an
+ * anonymous memory file so its contents can be frozen with
+ * `sfpool_freeze` after warm-up and cloned copy-on-write by
+ * `sfpool_thaw`. The same mapping holds an arena serving allocations
+ * larger than a block (such as a Lua state) so they are part of the
+ * template too; system malloc is used only once the arena is full.
+ * Pool memory is locked in RAM when within the memlock limit, as done
+ * by `sfpool_init`, and so are the clones made by `sfpool_thaw`.
+ *
+ * @param pool Pointer to the memory pool structure to initialize.
+ * @param snap Pointer to the snapshot structure to initialize.
+ * @param nmemb Number of blocks in the pool.
+ * @param blocksize Size of each block in bytes.
+ * @param arena_size Size in bytes of the arena for larger allocations.
+ * @return Total size of the memory pool in bytes, or 0 on failure.
+ */
+static inline size_t sfpool_snapshot_init(sfpool_t *pool, sfpool_snapshot_t *snap,
+                                          size_t nmemb, size_t blocksize,
+                                          size_t arena_size) {
+  if (pool == NULL || snap == NULL) return 0;
+  memset(pool, 0, sizeof(sfpool_t));
+  memset(snap, 0, sizeof(sfpool_snapshot_t));
+  snap->fd = -1;
+  if (!_sfpool_valid(nmemb, blocksize)) return 0;
+  if (arena_size > SIZE_MAX - nmemb * blocksize - ptr_align - struct_align) return 0;
+  // blocks are followed by the arena aligned to struct_align
+  size_t map_size = nmemb * blocksize + ptr_align + struct_align + arena_size;
+  int fd = (int)syscall(SYS_memfd_create, "sfpool", MFD_CLOEXEC);
+  if (fd < 0) return 0;
+  if (ftruncate(fd, map_size) != 0) {
+    close(fd);
+    return 0;
+  }
+  void *res = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | _sfutil_lockflag(map_size), fd, 0);
+  if (res == MAP_FAILED) {
+    close(fd);
+    return 0;
+  }
+  snap->fd = fd;
+  snap->base = (uint8_t*)res;
+  snap->map_size = map_size;
+  pool->buffer = snap->base;
+  size_t totalsize = _sfpool_format(pool, nmemb, blocksize);
+  if (arena_size > 0) {
+    ptr_t start = (ptr_t)(pool->data + pool->total_bytes);
+    start = (start + struct_align - 1) & ~(ptr_t)(struct_align - 1);
+    pool->arena = pool->arena_top = (uint8_t*)start;
+    pool->arena_end = snap->base + map_size;
+  }
+  return totalsize;
+}
+
+/**
+ * @brief Resets the pool to a fresh clone of its frozen template.
+ *
+ * All changes since the last freeze or thaw are discarded by mapping a
+ * new private copy-on-write view of the template over the pool, so the
+ * cost is a single mmap regardless of how many allocations were made.
+ * Pointers into the pool taken after the freeze become invalid, while
+ * those valid at freeze time are valid again. Allocations that fell
+ * back to system malloc since the freeze are not part of the template:
+ * they stay valid and counted as live, and must still be freed with
+ * `sfpool_free`. Clones are locked as their pages are touched, which
+ * keeps the copy-on-write laziness that locking the whole range at
+ * map time would break.
+ *
+ * @param pool Pointer to the memory pool created by `sfpool_snapshot_init`.
+ * @param snap Pointer to its frozen snapshot structure.
+ * @return 1 on success, 0 on failure.
+ */
+static inline int sfpool_thaw(sfpool_t *pool, sfpool_snapshot_t *snap) {
+  if (!snap->frozen) return 0;
+  void *res = mmap(snap->base, snap->map_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_FIXED, snap->fd, 0);
+  if (res == MAP_FAILED) return 0;
+  if (_sfutil_lockflag(snap->map_size))
+    syscall(SYS_mlock2, snap->base, snap->map_size, MLOCK_ONFAULT);
+  uint32_t live_fallbacks = pool->live_fallbacks;
+  memcpy(pool, &snap->state, sizeof(sfpool_t));
+  pool->live_fallbacks = live_fallbacks;
+  return 1;
+}
+
+/**
+ * @brief Freezes the current pool contents as a template.
+ *
+ * After this call the pool keeps working on a private copy-on-write
+ * clone of the template, which stays untouched. All pointers into
+ * the pool remain valid because clones are always mapped at the same
+ * address, which also means only one clone per process can be live at
+ * a time. Freezing is refused while allocations that fell back to
+ * system malloc are still live, since those would be shared by all
+ * clones: size the arena to hold all larger allocations made during
+ * warm-up.
+ *
+ * @param pool Pointer to the memory pool created by `sfpool_snapshot_init`.
+ * @param snap Pointer to its snapshot structure.
+ * @return 1 on success, 0 on failure.
+ */
+static inline int sfpool_freeze(sfpool_t *pool, sfpool_snapshot_t *snap) {
+  if (snap->fd < 0 || snap->frozen) return 0;
+  if (pool->buffer != snap->base) return 0;
+  if (pool->live_fallbacks != 0) return 0;
+  memcpy(&snap->state, pool, sizeof(sfpool_t));
+  snap->frozen = true;
+  return sfpool_thaw(pool, snap);
+}
+
+/**
+ * @brief Tears down a snapshot pool and its template.
+ *
+ * This function releases the pool mapping and the memory file holding
+ * the template; use it instead of `sfpool_teardown` on pools created by
+ * `sfpool_snapshot_init`.
+ *
+ * @param pool Pointer to the memory pool structure.
+ * @param snap Pointer to its snapshot structure.
+ */
+static inline void sfpool_snapshot_teardown(sfpool_t *pool, sfpool_snapshot_t *snap) {
+  if (snap->base) munmap(snap->base, snap->map_size);
+  if (snap->fd >= 0) close(snap->fd);
+  memset(snap, 0, sizeof(sfpool_snapshot_t));
+  snap->fd = -1;
+  memset(pool, 0, sizeof(sfpool_t));
+}
+
+/** @} */ // End of sfsnap group
+#endif // SFPOOL_SNAPSHOT
+
 #endif
@@ -0,0 +1,189 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * Copyright (C) 2025 Dyne.org foundation
+ * designed, written and maintained by Denis Roio <jaromil@dyne.org>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __SFPOOL_HPP__
+#define __SFPOOL_HPP__
+
+// C++17 adapters letting standard containers allocate from an sfpool.
+// Like sfpool.h this header carries its own implementation.
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+// sfpool.h is written in C: map its keywords for the C++ compiler,
+// preserving any restrict macro defined by the including program
+#pragma push_macro("restrict")
+#undef restrict
+#define restrict __restrict
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wregister"
+#endif
+#include <sfpool.h>
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#pragma pop_macro("restrict")
+
+namespace sfpool {
+
+/**
+ * @defgroup sfpoolxx C++ Allocator Adapters
+ * @{
+ */
+
+/**
+ * @brief Returns the alignment guaranteed by all pool allocations.
+ *
+ * Pool blocks are aligned to the lowest set bit of their base address
+ * and block size, while the malloc fallback is aligned to
+ * `std::max_align_t`: the smaller of the two holds for both.
+ *
+ * @param pool Pointer to the memory pool structure.
+ * @return Alignment in bytes.
+ */
+inline std::size_t pool_alignment(const sfpool_t *pool) noexcept {
+  ptr_t bits = (ptr_t)pool->data | pool->block_size;
+  return std::min<std::size_t>(bits & (~bits + 1), alignof(std::max_align_t));
+}
+
+/**
+ * @brief Allocates memory from the pool honouring an alignment.
+ *
+ * Alignments up to `sfpool::pool_alignment` are served by the pool, stricter
+ * ones by aligned `operator new`.
+ *
+ * @param pool Pointer to the memory pool structure.
+ * @param bytes Size of the memory block to allocate.
+ * @param alignment Required alignment, a power of two.
+ * @return Pointer to the allocated memory block.
+ * @throw std::bad_alloc when memory is exhausted.
+ */
+inline void *allocate(sfpool_t *pool, std::size_t bytes, std::size_t alignment) {
+  if (alignment > pool_alignment(pool))
+    return ::operator new(bytes, std::align_val_t(alignment));
+  void *ptr = sfpool_malloc(pool, bytes);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+/**
+ * @brief Frees memory allocated with `sfpool::allocate`.
+ *
+ * Over-aligned allocations go back to aligned `operator delete`, all
+ * the others to `sfpool_free`, which keeps the pool bookkeeping.
+ *
+ * @param pool Pointer to the memory pool structure.
+ * @param ptr Pointer to the memory block to free.
+ * @param bytes Size passed to the allocation.
+ * @param alignment Alignment passed to the allocation.
+ */
+inline void deallocate(sfpool_t *pool, void *ptr, std::size_t bytes,
+                       std::size_t alignment) noexcept {
+  if (alignment > pool_alignment(pool))
+    ::operator delete(ptr, bytes, std::align_val_t(alignment));
+  else
+    sfpool_free(pool, ptr);
+}
+
+/**
+ * @brief Polymorphic memory resource backed by an sfpool.
+ *
+ * Usable with all `std::pmr` containers. The resource does not own the
+ * pool, which must outlive it and all memory allocated through it.
+ */
+class memory_resource : public std::pmr::memory_resource {
+ public:
+  explicit memory_resource(sfpool_t *pool) noexcept : pool_(pool) {}
+
+  /** @return Pointer to the underlying memory pool structure. */
+  sfpool_t *pool() const noexcept { return pool_; }
+
+ private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return sfpool::allocate(pool_, bytes, alignment);
+  }
+
+  void do_deallocate(void *ptr, std::size_t bytes,
+                     std::size_t alignment) override {
+    sfpool::deallocate(pool_, ptr, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    const memory_resource *o = dynamic_cast<const memory_resource*>(&other);
+    return o != nullptr && o->pool_ == pool_;
+  }
+
+  sfpool_t *pool_;
+};
+
+/**
+ * @brief Stateful STL allocator backed by an sfpool.
+ *
+ * Allocators compare equal when they share the same pool, which must
+ * outlive every container using them.
+ */
+template <typename T>
+class allocator {
+ public:
+  using value_type = T;
+
+  explicit allocator(sfpool_t *pool) noexcept : pool_(pool) {}
+
+  template <typename U>
+  allocator(const allocator<U> &other) noexcept : pool_(other.pool()) {}
+
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T*>(sfpool::allocate(pool_, n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *ptr, std::size_t n) noexcept {
+    sfpool::deallocate(pool_, ptr, n * sizeof(T), alignof(T));
+  }
+
+  /** @return Pointer to the underlying memory pool structure. */
+  sfpool_t *pool() const noexcept { return pool_; }
+
+  template <typename U>
+  bool operator==(const allocator<U> &other) const noexcept {
+    return pool_ == other.pool();
+  }
+
+  template <typename U>
+  bool operator!=(const allocator<U> &other) const noexcept {
+    return pool_ != other.pool();
+  }
+
+ private:
+  sfpool_t *pool_;
+};
+
+/** @} */ // End of sfpoolxx group
+
+}  // namespace sfpool
+
+#endif
@@ -0,0 +1,72 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// Hot path cost of the free-list links: sfpool_malloc drains a warm pool
+// and sfpool_free gives its blocks back. Build with -DNO_SECURE_ZERO to
+// leave out the zeroing of each block, which would otherwise dominate
+// the timing.
+
+#include <sfpool.h>
+
+#include <time.h>
+
+#ifndef ROUNDS
+#define ROUNDS 2000
+#endif
+
+#ifndef REPEAT
+#define REPEAT 7
+#endif
+
+static double run(sfpool_t *pool, void **ptrs, int blocknum) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < blocknum; i++) ptrs[i] = sfpool_malloc(pool, 8);
+    // free in interleaved order to shuffle the free list
+    for (int s = 0; s < 2; s++)
+      for (int i = s; i < blocknum; i += 2) sfpool_free(pool, ptrs[i]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+  return ns / ((double)ROUNDS * blocknum);
+}
+
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+  int blocknum = (argc > 1) ? atoi(argv[1]) : 0;
+  if (!blocknum) blocknum = 4096;
+  int blocksize = (argc > 2) ? atoi(argv[2]) : 0;
+  if (!blocksize) blocksize = 64;
+
+  sfpool_t pool;
+  if (sfpool_init(&pool, blocknum, blocksize) == 0) {
+    fprintf(stderr, "Cannot init sfpool %i x %i\n", blocknum, blocksize);
+    return 1;
+  }
+  void **ptrs = malloc(blocknum * sizeof(void*));
+  if (ptrs == NULL) return 1;
+
+  double ns[REPEAT];
+  run(&pool, ptrs, blocknum); // warm up
+  for (int i = 0; i < REPEAT; i++) ns[i] = run(&pool, ptrs, blocknum);
+  qsort(ns, REPEAT, sizeof(double), cmp_double);
+
+  fprintf(stdout, "%-14s %i blocks %i B: %.2f ns per malloc+free"
+          " (median of %i, min %.2f max %.2f)\n",
+#ifdef SAFE_LINKING
+          "safe-linking",
+#else
+          "plain-linking",
+#endif
+          blocknum, blocksize, ns[REPEAT / 2], REPEAT, ns[0], ns[REPEAT - 1]);
+
+  free(ptrs);
+  sfpool_teardown(&pool);
+  return 0;
+}
@@ -0,0 +1,102 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <sfpool.h>
+
+typedef struct octet_t {
+  uint32_t max;
+  uint32_t len;
+  uint8_t key[32];
+} octet_t;
+
+static int constructed = 0;
+static int destructed = 0;
+
+static void octet_ctor(void *obj) {
+  octet_t *o = (octet_t*)obj;
+  o->max = sizeof(o->key);
+  o->len = 0;
+  memset(o->key, 0xAA, sizeof(o->key));
+  constructed++;
+}
+
+static void octet_dtor(void *obj) {
+  (void)obj;
+  destructed++;
+}
+
+int main(void) {
+  sfpool_t pool;
+  sfpool_cache_t *cache = NULL;
+  octet_t *a = NULL;
+  octet_t *b = NULL;
+
+  assert(sfpool_init(&pool, 16, 128) == 16 * 128);
+  cache = sfpool_cache_create(&pool, sizeof(octet_t), octet_ctor, octet_dtor);
+  assert(cache != NULL);
+  assert(sfpool_cache_secret(cache, offsetof(octet_t, key), 32) == 1);
+  assert(sfpool_cache_secret(cache, sizeof(octet_t), 1) == 0);
+
+  a = sfpool_cache_alloc(cache);
+  assert(a != NULL);
+  assert(sfpool_contains(&pool, a) == 1);
+  assert(a->max == 32);
+  assert(constructed == 1);
+  // secret fields are zero also right after construction
+  for (size_t i = 0; i < sizeof(a->key); ++i) assert(a->key[i] == 0);
+  a->len = 5;
+  a->key[0] = 0x42;
+
+  // freed objects keep their header but lose the secret field
+  sfpool_cache_free(cache, a);
+  b = sfpool_cache_alloc(cache);
+  assert(b == a);
+  assert(constructed == 1);
+  assert(b->max == 32);
+  assert(b->len == 5);
+  for (size_t i = 0; i < sizeof(b->key); ++i) assert(b->key[i] == 0);
+
+  a = sfpool_cache_alloc(cache);
+  assert(a != b);
+  assert(constructed == 2);
+#ifdef PROFILING
+  assert(cache->hits_total == 1);
+  assert(cache->miss_total == 2);
+#endif
+
+  sfpool_cache_free(cache, a);
+  sfpool_cache_free(cache, b);
+  assert(cache->free_count == 2);
+  sfpool_cache_status(cache);
+  assert(sfpool_cache_reap(cache) == 2);
+  assert(destructed == 2);
+  sfpool_cache_destroy(cache);
+  assert(pool.free_count == pool.total_blocks);
+
+  // objects and their link must fit in a block
+  assert(sfpool_cache_create(&pool, 256, NULL, NULL) == NULL);
+  assert(sfpool_cache_create(&pool, 128 - sizeof(void*) + 1, NULL, NULL) == NULL);
+  cache = sfpool_cache_create(&pool, 128 - sizeof(void*), NULL, octet_dtor);
+  assert(cache != NULL);
+
+  // objects from system malloc on an exhausted pool are not kept idle
+  void *blocks[16];
+  for (int i = 0; i < 16; i++) blocks[i] = sfpool_malloc(&pool, 8);
+  uint32_t live = pool.live_fallbacks;
+  destructed = 0;
+  a = sfpool_cache_alloc(cache);
+  assert(sfpool_contains(&pool, a) == 0);
+  sfpool_cache_free(cache, a);
+  assert(cache->free_count == 0);
+  assert(destructed == 1);
+  assert(pool.live_fallbacks == live);
+  for (int i = 0; i < 16; i++) sfpool_free(&pool, blocks[i]);
+  sfpool_cache_destroy(cache);
+
+  sfpool_teardown(&pool);
+  return 0;
+}
@@ -21,9 +21,18 @@ int main(void) {
   assert(heap_ptr != NULL);
   assert(sfpool_contains(&pool, heap_ptr) == 0);
 
+#ifdef PROFILING
+  uint32_t misses = pool.miss_total;
+  size_t miss_bytes = pool.miss_bytes;
+#endif
   heap_ptr = sfpool_realloc(&pool, heap_ptr, 256);
   assert(heap_ptr != NULL);
   assert(sfpool_contains(&pool, heap_ptr) == 0);
+#ifdef PROFILING
+  // system reallocs are profiled as misses
+  assert(pool.miss_total == misses + 1);
+  assert(pool.miss_bytes == miss_bytes + 256);
+#endif
 
   sfpool_free(&pool, heap_ptr);
   sfpool_free(&pool, pool_ptr);
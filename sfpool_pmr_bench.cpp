@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// Throughput of node based containers on sfpool versus the default allocator.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <memory_resource>
+#include <unordered_map>
+
+#include <sfpool.hpp>
+
+#ifndef ROUNDS
+#define ROUNDS 200
+#endif
+
+#ifndef ENTRIES
+#define ENTRIES 10000
+#endif
+
+using bench_clock = std::chrono::steady_clock;
+
+static double elapsed_ms(bench_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+static double bench_map(std::pmr::memory_resource *res) {
+  auto start = bench_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    std::pmr::unordered_map<int, int> map(res);
+    for (int i = 0; i < ENTRIES; i++) map.emplace(i, r);
+    for (int i = 0; i < ENTRIES; i += 2) map.erase(i);
+  }
+  return elapsed_ms(start);
+}
+
+template <typename Alloc>
+static double bench_list(const Alloc &alloc) {
+  auto start = bench_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    std::list<int, Alloc> list(alloc);
+    for (int i = 0; i < ENTRIES; i++) list.push_back(i);
+    while (!list.empty()) list.pop_front();
+  }
+  return elapsed_ms(start);
+}
+
+static void report(const char *name, double sys, double pool) {
+  fprintf(stdout, "%-22s %10.2f ms %10.2f ms %8.2fx\n",
+          name, sys, pool, pool > 0 ? sys / pool : 0);
+}
+
+int main(int argc, char **argv) {
+  int blocknum = (argc > 1) ? atoi(argv[1]) : 0;
+  if (!blocknum) blocknum = 16384;
+  int blocksize = (argc > 2) ? atoi(argv[2]) : 0;
+  if (!blocksize) blocksize = 64;
+
+  sfpool_t pool;
+  if (sfpool_init(&pool, blocknum, blocksize) == 0) {
+    fprintf(stderr, "Cannot init sfpool %i x %i\n", blocknum, blocksize);
+    return 1;
+  }
+  sfpool::memory_resource res(&pool);
+
+  fprintf(stdout, "Benchmark %u rounds of %u entries, sfpool %i blocks %i B each\n",
+          ROUNDS, ENTRIES, blocknum, blocksize);
+  fprintf(stdout, "%-22s %13s %13s %9s\n", "container", "default", "sfpool", "speedup");
+  report("pmr::unordered_map",
+         bench_map(std::pmr::new_delete_resource()), bench_map(&res));
+  report("list",
+         bench_list(std::allocator<int>()),
+         bench_list(sfpool::allocator<int>(&pool)));
+  fflush(stdout);
+  sfpool_status(&pool);
+
+  sfpool_teardown(&pool);
+  return 0;
+}
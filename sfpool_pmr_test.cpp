@@ -0,0 +1,80 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// a restrict macro of the program survives the include
+#define restrict __restrict__
+#include <sfpool.hpp>
+#if !defined(restrict)
+#error "sfpool.hpp clobbered the restrict macro"
+#endif
+
+struct alignas(64) wide_t {
+  uint8_t bytes[64];
+};
+
+int main() {
+  sfpool_t pool;
+  assert(sfpool_init(&pool, 256, 64) == 256 * 64);
+
+  {
+    sfpool::memory_resource res(&pool);
+    sfpool::memory_resource same(&pool);
+    assert(res.is_equal(same));
+    assert(!res.is_equal(*std::pmr::new_delete_resource()));
+
+    std::pmr::unordered_map<int, std::pmr::string> map(&res);
+    for (int i = 0; i < 100; i++)
+      map.emplace(i, std::pmr::string("sailfish pool entry", &res));
+    assert(map.size() == 100);
+    assert(pool.free_count < pool.total_blocks);
+
+    // stricter alignments than the pool guarantees are still honoured
+    void *wide = res.allocate(sizeof(wide_t), alignof(wide_t));
+    assert(reinterpret_cast<uintptr_t>(wide) % alignof(wide_t) == 0);
+    res.deallocate(wide, sizeof(wide_t), alignof(wide_t));
+
+    // default max_align_t alignment is served by the pool
+    void *small = res.allocate(32);
+    assert(sfpool_contains(&pool, small) == 1);
+    res.deallocate(small, 32);
+
+    // sized deallocation of a fallback allocation
+    uint32_t misses = pool.miss_total;
+    uint32_t live = pool.live_fallbacks;
+    void *big = res.allocate(1024, 8);
+    assert(sfpool_contains(&pool, big) == 0);
+    assert(pool.miss_total == misses + 1);
+    assert(pool.live_fallbacks == live + 1);
+    res.deallocate(big, 1024, 8);
+    assert(pool.live_fallbacks == live);
+  }
+  assert(pool.free_count == pool.total_blocks);
+  assert(pool.live_fallbacks == 0);
+
+  {
+    sfpool::allocator<int> alloc(&pool);
+    sfpool::allocator<long> rebound(alloc);
+    assert(alloc == rebound);
+
+    std::list<int, sfpool::allocator<int>> list(alloc);
+    for (int i = 0; i < 100; i++) list.push_back(i);
+    assert(sfpool_contains(&pool, &list.front()) == 1);
+
+    std::map<int, int, std::less<int>,
+             sfpool::allocator<std::pair<const int, int>>> tree(alloc);
+    for (int i = 0; i < 50; i++) tree[i] = i;
+    assert(tree.size() == 50);
+  }
+  assert(pool.free_count == pool.total_blocks);
+
+  sfpool_teardown(&pool);
+  return 0;
+}
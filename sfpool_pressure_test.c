@@ -0,0 +1,127 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <sfpool.h>
+
+static int calls = 0;
+static void *kept[4];
+static int nkept = 0;
+
+static void drain_cache(sfpool_t *pool, void *ud) {
+  sfpool_cache_t *cache = (sfpool_cache_t*)ud;
+  // reentrant allocations must not call us again
+  void *tmp = sfpool_malloc(pool, 1);
+  sfpool_free(pool, tmp);
+  sfpool_cache_reap(cache);
+  calls++;
+}
+
+// reclaims nothing on the first call, then one block per call
+static void release_late(sfpool_t *pool, void *ud) {
+  (void)ud;
+  if (calls++ > 0 && nkept > 0) sfpool_free(pool, kept[--nkept]);
+}
+
+int main(void) {
+  sfpool_t pool;
+  sfpool_cache_t *cache = NULL;
+  void *objs[3];
+  void *ptr = NULL;
+
+  assert(sfpool_init(&pool, 4, 64) == 256);
+  cache = sfpool_cache_create(&pool, 32, NULL, NULL);
+  assert(cache != NULL);
+  assert(sfpool_contains(&pool, cache) == 0); // descriptor is larger than a block
+
+  // fill the pool with idle cached objects
+  for (int i = 0; i < 3; i++) objs[i] = sfpool_cache_alloc(cache);
+  for (int i = 0; i < 3; i++) sfpool_cache_free(cache, objs[i]);
+  ptr = sfpool_malloc(&pool, 8);
+  assert(pool.free_list == NULL);
+
+  // without a callback the next allocation falls back
+  void *heap = sfpool_malloc(&pool, 8);
+  assert(sfpool_contains(&pool, heap) == 0);
+  sfpool_free(&pool, heap);
+
+  sfpool_set_pressure_cb(&pool, drain_cache, cache, 0);
+  void *reclaimed = sfpool_malloc(&pool, 8);
+  assert(calls == 1);
+  assert(sfpool_contains(&pool, reclaimed) == 1);
+  assert(cache->free_count == 0);
+#ifdef PROFILING
+  assert(pool.pressure_calls == 1);
+  assert(pool.pressure_saved == 1);
+#endif
+
+  // not invoked above the watermark nor for large allocations
+  sfpool_free(&pool, reclaimed);
+  heap = sfpool_malloc(&pool, 128);
+  sfpool_free(&pool, heap);
+  assert(calls == 1);
+
+  // invoked ahead of exhaustion with a watermark
+  for (int i = 0; i < 2; i++) objs[i] = sfpool_cache_alloc(cache);
+  for (int i = 0; i < 2; i++) sfpool_cache_free(cache, objs[i]);
+  assert(pool.free_count == 1);
+  sfpool_set_pressure_cb(&pool, drain_cache, cache, 2);
+  void *held[4];
+  held[0] = sfpool_malloc(&pool, 8);
+  assert(calls == 2);
+  assert(pool.free_count == 2);
+#ifdef PROFILING
+  assert(pool.pressure_saved == 1);
+  assert(pool.pressure_blocks == 5);
+#endif
+
+  // a call reclaiming nothing is not repeated below the watermark
+  held[1] = sfpool_malloc(&pool, 8);
+  assert(calls == 3);
+  held[2] = sfpool_malloc(&pool, 8);
+  assert(calls == 3);
+#ifdef PROFILING
+  assert(pool.pressure_saved == 1);
+#endif
+
+  // and is re-armed once frees bring the pool above it
+  for (int i = 0; i < 3; i++) sfpool_free(&pool, held[i]);
+  held[0] = sfpool_malloc(&pool, 8);
+  assert(calls == 3);
+  held[1] = sfpool_malloc(&pool, 8);
+  assert(calls == 4);
+  sfpool_status(&pool);
+
+  sfpool_free(&pool, held[0]);
+  sfpool_free(&pool, held[1]);
+  sfpool_free(&pool, ptr);
+  sfpool_cache_destroy(cache);
+  assert(pool.free_count == 4);
+
+  // a fruitless call above zero does not skip the call on exhaustion
+  calls = 0;
+  sfpool_set_pressure_cb(&pool, release_late, NULL, 4);
+  for (int i = 0; i < 4; i++) kept[nkept++] = sfpool_malloc(&pool, 8);
+  assert(calls == 1);
+  assert(pool.free_list == NULL);
+#ifdef PROFILING
+  uint32_t saved = pool.pressure_saved;
+#endif
+  held[0] = sfpool_malloc(&pool, 8);
+  held[1] = sfpool_malloc(&pool, 8);
+  assert(calls == 3);
+  assert(sfpool_contains(&pool, held[0]) == 1);
+  assert(sfpool_contains(&pool, held[1]) == 1);
+  assert(pool.live_fallbacks == 0);
+#ifdef PROFILING
+  assert(pool.pressure_saved == saved + 2);
+#endif
+  sfpool_free(&pool, held[0]);
+  sfpool_free(&pool, held[1]);
+  while (nkept > 0) sfpool_free(&pool, kept[--nkept]);
+  sfpool_teardown(&pool);
+  return 0;
+}
@@ -0,0 +1,94 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <sfpool.h>
+
+#if defined(SAFE_LINKING) && !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <signal.h>
+#include <sys/wait.h>
+
+// Overwrite the link of a freed block and allocate twice: the child
+// process must abort instead of returning the forged address.
+static void expect_abort(uint8_t *forged) {
+  sfpool_t pool;
+  assert(sfpool_init(&pool, 8, 64) == 512);
+  uint8_t *block = sfpool_malloc(&pool, 8);
+  sfpool_free(&pool, block);
+  fflush(stderr);
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    if (forged == NULL) forged = pool.data + 1; // misaligned
+    *(uint8_t **)block = forged; // use after free
+    void *a = sfpool_malloc(&pool, 8);
+    void *b = sfpool_malloc(&pool, 8);
+    (void)a;
+    (void)b;
+    _exit(0);
+  }
+  int status = 0;
+  assert(waitpid(pid, &status, 0) == pid);
+  assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+  sfpool_teardown(&pool);
+}
+
+// Same for the link of an idle object in a cache.
+static void expect_cache_abort(uint8_t *forged) {
+  sfpool_t pool;
+  assert(sfpool_init(&pool, 8, 64) == 512);
+  sfpool_cache_t *cache = sfpool_cache_create(&pool, 32, NULL, NULL);
+  uint8_t *obj = sfpool_cache_alloc(cache);
+  sfpool_cache_free(cache, obj);
+  fflush(stderr);
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    *(uint8_t **)(obj + cache->link_offset) = forged; // use after free
+    void *a = sfpool_cache_alloc(cache);
+    void *b = sfpool_cache_alloc(cache);
+    (void)a;
+    (void)b;
+    _exit(0);
+  }
+  int status = 0;
+  assert(waitpid(pid, &status, 0) == pid);
+  assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+  sfpool_cache_destroy(cache);
+  sfpool_teardown(&pool);
+}
+
+int main(void) {
+  sfpool_t pool;
+  static uint8_t outside[64];
+  void *ptrs[8];
+
+  // regular use decodes every link
+  assert(sfpool_init(&pool, 8, 64) == 512);
+  for (int i = 0; i < 8; i++) {
+    ptrs[i] = sfpool_malloc(&pool, 8);
+    assert(sfpool_contains(&pool, ptrs[i]) == 1);
+  }
+  for (int i = 7; i >= 0; i -= 2) sfpool_free(&pool, ptrs[i]);
+  for (int i = 6; i >= 0; i -= 2) sfpool_free(&pool, ptrs[i]);
+  for (int i = 0; i < 8; i++) {
+    ptrs[i] = sfpool_malloc(&pool, 8);
+    assert(sfpool_contains(&pool, ptrs[i]) == 1);
+  }
+  assert(pool.free_list == NULL);
+  for (int i = 0; i < 8; i++) sfpool_free(&pool, ptrs[i]);
+  sfpool_teardown(&pool);
+
+  expect_abort(outside);
+  expect_abort(NULL);
+  expect_cache_abort(outside);
+  return 0;
+}
+#else
+int main(void) {
+  return 0;
+}
+#endif
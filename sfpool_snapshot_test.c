@@ -0,0 +1,100 @@
+/* SPDX-FileCopyrightText: 2025 Dyne.org foundation
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <sfpool.h>
+
+#ifdef SFPOOL_SNAPSHOT
+typedef struct node_t {
+  struct node_t *next;
+  uint32_t value;
+} node_t;
+
+int main(void) {
+  sfpool_t pool;
+  sfpool_snapshot_t snap;
+  node_t *head = NULL;
+  uint8_t *state = NULL;
+  uint32_t free_at_freeze;
+
+  assert(sfpool_snapshot_init(&pool, &snap, 64, 32, 4096) == 64 * 32);
+  assert(sfpool_thaw(&pool, &snap) == 0); // not frozen yet
+
+  // warm-up: a linked structure with pointers inside the pool
+  for (uint32_t i = 0; i < 8; i++) {
+    node_t *n = sfpool_malloc(&pool, sizeof(node_t));
+    assert(sfpool_contains(&pool, n) == 1);
+    n->next = head;
+    n->value = i;
+    head = n;
+  }
+  // larger than a block, as a Lua state is: served by the arena
+  state = sfpool_malloc(&pool, 1024);
+  assert(sfpool_contains(&pool, state) == 0);
+  memset(state, 0x5A, 1024);
+  void *temp = sfpool_malloc(&pool, 512);
+  sfpool_free(&pool, temp);
+  assert(pool.live_fallbacks == 0);
+  free_at_freeze = pool.free_count;
+  assert(sfpool_freeze(&pool, &snap) == 1);
+  assert(sfpool_freeze(&pool, &snap) == 0);
+
+  for (int round = 0; round < 3; round++) {
+    // request: mutate the template state and allocate more
+    head->value = 100;
+    void *extra[16];
+    for (int i = 0; i < 16; i++) extra[i] = sfpool_malloc(&pool, 16);
+    assert(pool.free_count == free_at_freeze - 16);
+    sfpool_free(&pool, head->next);
+    (void)extra;
+    state[0] = 0;
+    assert(sfpool_realloc(&pool, state, 2048) == state); // grows in place
+    void *big = sfpool_malloc(&pool, 1024);
+    assert(big != NULL && pool.live_fallbacks == 0);
+    void *heap = sfpool_malloc(&pool, 4096); // arena is full
+    assert(pool.live_fallbacks == 1);
+    sfpool_free(&pool, heap);
+    assert(pool.live_fallbacks == 0);
+
+    // next request starts again from the template
+    assert(sfpool_thaw(&pool, &snap) == 1);
+    assert(pool.free_count == free_at_freeze);
+    uint32_t expect = 7;
+    for (node_t *n = head; n != NULL; n = n->next) assert(n->value == expect--);
+    assert(expect == UINT32_MAX);
+    for (int i = 0; i < 1024; i++) assert(state[i] == 0x5A);
+  }
+
+  sfpool_snapshot_teardown(&pool, &snap);
+
+  // pools with live system malloc allocations cannot be frozen
+  assert(sfpool_snapshot_init(&pool, &snap, 1, 32, 0) == 32);
+  void *in = sfpool_malloc(&pool, 8);
+  void *out = sfpool_malloc(&pool, 8);
+  assert(sfpool_contains(&pool, out) == 0);
+  assert(pool.live_fallbacks == 1);
+  assert(sfpool_freeze(&pool, &snap) == 0);
+  // but they can once those are freed
+  sfpool_free(&pool, out);
+  assert(sfpool_freeze(&pool, &snap) == 1);
+  sfpool_free(&pool, in);
+
+  // system malloc allocations survive a thaw and are still counted
+  in = sfpool_malloc(&pool, 8);
+  out = sfpool_malloc(&pool, 8);
+  assert(pool.live_fallbacks == 1);
+  assert(sfpool_thaw(&pool, &snap) == 1);
+  assert(pool.live_fallbacks == 1);
+  sfpool_free(&pool, out);
+  assert(pool.live_fallbacks == 0);
+  sfpool_snapshot_teardown(&pool, &snap);
+  return 0;
+}
+#else
+int main(void) {
+  return 0;
+}
+#endif
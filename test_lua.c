@@ -29,6 +29,11 @@
 // sailfish pool
 #include <sfpool.h>
 
+#if defined(LUA_BENCH)
+#include <time.h>
+#include <sys/resource.h>
+#endif
+
 static sfpool_t *SFP;
 
 // Custom memory allocation function
@@ -44,12 +49,43 @@ void *custom_lua_mem(void *ud, void *ptr, size_t osize, size_t nsize);
 #define lua_free(ptr)          sfpool_free(SFP,ptr)
 #endif
 
+#if defined(LUA_BENCH)
+// One line report parsed by bench_lua.sh:
+// sfpool-bench <wall ms> <peak rss KB> <hits> <misses> <fallback bytes>
+static void bench_report(const struct timespec *start) {
+  struct timespec now;
+  struct rusage ru;
+  uint32_t hits = 0, misses = 0;
+  size_t miss_bytes = 0;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  getrusage(RUSAGE_SELF, &ru);
+  double ms = (now.tv_sec - start->tv_sec) * 1e3
+    + (now.tv_nsec - start->tv_nsec) / 1e6;
+#if defined(__APPLE__)
+  long rss = ru.ru_maxrss / 1024; // reported in bytes
+#else
+  long rss = ru.ru_maxrss; // reported in kilobytes
+#endif
+#if defined(MEM_SFPOOL)
+  hits = SFP->hits_total;
+  misses = SFP->miss_total;
+  miss_bytes = SFP->miss_bytes;
+#endif
+  fprintf(stderr, "sfpool-bench %.2f %ld %u %u %zu\n",
+          ms, rss, hits, misses, miss_bytes);
+}
+#endif
+
 int main(int argc, char* argv[]) {
     if (argc != 4) {
         fprintf(stderr, "Usage: %s <lua_script_path> blocks blocksize\n", argv[0]);
         return 1;
     }
     const char* script_path = argv[1];
+#if defined(LUA_BENCH)
+    struct timespec bench_start;
+    clock_gettime(CLOCK_MONOTONIC, &bench_start);
+#endif
 #if defined(MEM_SFPOOL)
     SFP = malloc(sizeof(sfpool_t));
     sfpool_init(SFP, atoi(argv[2]),atoi(argv[3]));
@@ -78,6 +114,9 @@ int main(int argc, char* argv[]) {
     }
     // Clean up and exit
     lua_close(L);
+#if defined(LUA_BENCH)
+    bench_report(&bench_start);
+#endif
 #if defined(MEM_SFPOOL)
     sfpool_status(SFP);
     sfpool_teardown(SFP);